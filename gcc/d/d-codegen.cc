@@ -2538,11 +2538,42 @@ get_frameinfo (FuncDeclaration *fd)
 
   DECL_LANG_FRAMEINFO (fds) = ffi;
 
+  FuncDeclaration *escaping = NULL;
   if (fd->needsClosure ())
+    {
+      /* The front-end decides whether a closure is needed before the
+	 attributes of all called functions are known.  Check again whether
+	 any nested function can outlive FD.  */
+      if (flag_stack_closures)
+	escaping = fd->escapingNestedFunc ();
+      else
+	escaping = fd;
+    }
+
+  if (escaping != NULL)
     {
       /* Set-up a closure frame, this will be allocated on the heap.  */
       FRAMEINFO_CREATES_FRAME (ffi) = 1;
       FRAMEINFO_IS_CLOSURE (ffi) = 1;
+
+      if (warn_closure)
+	{
+	  if (escaping != fd)
+	    warning_at (make_location_t (fd->loc), OPT_Wclosure,
+			"%qs allocates a closure on the GC heap because "
+			"nested function %qs may escape", fd->toPrettyChars (),
+			escaping->toPrettyChars ());
+	  else
+	    warning_at (make_location_t (fd->loc), OPT_Wclosure,
+			"%qs allocates a closure on the GC heap",
+			fd->toPrettyChars ());
+	}
+    }
+  else if (fd->needsClosure ())
+    {
+      /* No nested function outlives FD, so the frame can be built on the
+	 stack, same as for nested functions that are never escaped.  */
+      FRAMEINFO_CREATES_FRAME (ffi) = 1;
     }
   else if (fd->hasNestedFrameRefs ())
     {
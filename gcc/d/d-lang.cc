@@ -34,6 +34,8 @@ along with GCC; see the file COPYING3.  If not see
 #include "dmd/module.h"
 #include "dmd/mtype.h"
 #include "dmd/target.h"
+#include "dmd/timetrace.h"
+#include "dmd/tokencache.h"
 
 #include "opts.h"
 #include "alias.h"
@@ -77,9 +79,17 @@ struct d_option_data
   bool deps_phony;		    /* -MP  */
 
   bool stdinc;			    /* -nostdinc  */
+
+  unsigned parse_threads;	    /* -fparse-threads=<n>  */
+
+  bool time_report;		    /* -ftime-report-d  */
+  const char *time_report_filename; /* -ftime-report-d=<file>  */
 }
 d_option;
 
+/* Number of template instances and CTFE calls listed by -ftime-report-d.  */
+#define D_TIME_REPORT_TOPN 20
+
 /* List of modules being compiled.  */
 static Modules builtin_modules;
 
@@ -299,6 +309,9 @@ d_init_options (unsigned int, cl_decoded_option *decoded_options)
   d_option.deps_target = NULL;
   d_option.deps_phony = false;
   d_option.stdinc = true;
+  d_option.parse_threads = 1;
+  d_option.time_report = false;
+  d_option.time_report_filename = NULL;
 }
 
 /* Implements the lang_hooks.init_options_struct routine for language D.
@@ -498,6 +511,18 @@ d_handle_option (size_t scode, const char *arg, HOST_WIDE_INT value,
       d_option.fonly = arg;
       break;
 
+    case OPT_fparse_threads_:
+      {
+	int threads = integral_argument (arg);
+	if (threads < 1)
+	  {
+	    error ("bad argument for -fparse-threads %qs", arg);
+	    break;
+	  }
+	d_option.parse_threads = threads;
+	break;
+      }
+
     case OPT_fpostconditions:
       global.params.useOut = value;
       break;
@@ -519,6 +544,24 @@ d_handle_option (size_t scode, const char *arg, HOST_WIDE_INT value,
 	? CHECKENABLEon : CHECKENABLEoff;
       break;
 
+    case OPT_ftime_report_d:
+      d_option.time_report = value;
+      break;
+
+    case OPT_ftime_report_d_:
+      d_option.time_report = true;
+      d_option.time_report_filename = arg;
+      break;
+
+    case OPT_ftoken_cache_:
+      if (!FileName::ensurePathExists (arg))
+	{
+	  error ("unable to create directory %qs for -ftoken-cache", arg);
+	  break;
+	}
+      tokenCacheInit (arg);
+      break;
+
     case OPT_ftransition_all:
       global.params.vtls = value;
       global.params.vfield = value;
@@ -1006,6 +1049,9 @@ d_add_entrypoint_module (Module *entry, Module *root)
 void
 d_parse_file (void)
 {
+  if (d_option.time_report)
+    timeTraceInit (D_TIME_REPORT_TOPN);
+
   if (global.params.verbose)
     {
       message ("binary    %s", global.params.argv0.ptr);
@@ -1039,6 +1085,14 @@ d_parse_file (void)
   if (d_option.fonly && strcmp (d_option.fonly, main_input_filename) != 0)
     error ("-fonly= argument is different from first input file name");
 
+  /* Instances are only shared out if every compilation emits the others
+     as weak definitions that can be referenced from any object.  */
+  if (flag_only_emit_owned && (!d_option.fonly || !flag_weak))
+    {
+      warning (0, "-fonly-emit-owned is ignored without -fonly= and -fweak");
+      flag_only_emit_owned = 0;
+    }
+
   for (size_t i = 0; i < num_in_fnames; i++)
     {
       if (strcmp (in_fnames[i], "-") == 0)
@@ -1084,11 +1138,21 @@ d_parse_file (void)
 	}
     }
 
+  /* Read and parse all D source files ahead on multiple threads.  */
+  if (d_option.parse_threads > 1)
+    {
+      timeTraceBeginPhase (TIMETRACEparse, NULL);
+      Module::preparse (&modules, d_option.parse_threads);
+      timeTraceEndPhase ();
+    }
+
   /* Read all D source files.  */
   for (size_t i = 0; i < modules.dim; i++)
     {
       Module *m = modules[i];
+      timeTraceBeginPhase (TIMETRACEread, m);
       m->read (Loc ());
+      timeTraceEndPhase ();
     }
 
   /* Parse all D source files.  */
@@ -1103,7 +1167,9 @@ d_parse_file (void)
 	Module::rootModule = m;
 
       m->importedFrom = m;
+      timeTraceBeginPhase (TIMETRACEparse, m);
       m->parse ();
+      timeTraceEndPhase ();
       Compiler::loadModule (m);
 
       if (m->isDocFile)
@@ -1160,7 +1226,9 @@ d_parse_file (void)
       if (global.params.verbose)
 	message ("importall %s", m->toChars ());
 
+      timeTraceBeginPhase (TIMETRACEimportAll, m);
       m->importAll (NULL);
+      timeTraceEndPhase ();
     }
 
   if (global.errors)
@@ -1176,12 +1244,16 @@ d_parse_file (void)
       if (global.params.verbose)
 	message ("semantic  %s", m->toChars ());
 
+      timeTraceBeginPhase (TIMETRACEsemantic, m);
       dsymbolSemantic (m, NULL);
+      timeTraceEndPhase ();
     }
 
   /* Do deferred semantic analysis.  */
+  timeTraceBeginPhase (TIMETRACEdeferred, NULL);
   Module::dprogress = 1;
   Module::runDeferredSemantic ();
+  timeTraceEndPhase ();
 
   if (Module::deferred.dim)
     {
@@ -1208,10 +1280,14 @@ d_parse_file (void)
       if (global.params.verbose)
 	message ("semantic2 %s", m->toChars ());
 
+      timeTraceBeginPhase (TIMETRACEsemantic2, m);
       semantic2 (m, NULL);
+      timeTraceEndPhase ();
     }
 
+  timeTraceBeginPhase (TIMETRACEdeferred, NULL);
   Module::runDeferredSemantic2 ();
+  timeTraceEndPhase ();
 
   if (global.errors)
     goto had_errors;
@@ -1224,10 +1300,14 @@ d_parse_file (void)
       if (global.params.verbose)
 	message ("semantic3 %s", m->toChars ());
 
+      timeTraceBeginPhase (TIMETRACEsemantic3, m);
       semantic3 (m, NULL);
+      timeTraceEndPhase ();
     }
 
+  timeTraceBeginPhase (TIMETRACEdeferred, NULL);
   Module::runDeferredSemantic3 ();
+  timeTraceEndPhase ();
 
   /* Check again, incase semantic3 pass loaded any more modules.  */
   while (builtin_modules.dim != 0)
@@ -1319,6 +1399,9 @@ d_parse_file (void)
 	}
     }
 
+  if (flag_only_emit_owned)
+    set_instance_owners (&modules);
+
   for (size_t i = 0; i < modules.dim; i++)
     {
       Module *m = modules[i];
@@ -1330,13 +1413,22 @@ d_parse_file (void)
 
       if (!flag_syntax_only)
 	{
+	  timeTraceBeginPhase (TIMETRACEcodegen, m);
 	  if ((entrypoint_module != NULL) && (m == entrypoint_root_module))
 	    build_decl_tree (entrypoint_module);
 
 	  build_decl_tree (m);
+	  timeTraceEndPhase ();
 	}
     }
 
+  /* Generate the TypeInfo referenced by all code generated above.  */
+  if (!flag_syntax_only)
+    finish_typeinfo_decls ();
+
+  if (global.params.verbose && !flag_syntax_only)
+    mangle_decl_statistics ();
+
   /* And end the main input file, if the debug writer wants it.  */
   if (debug_hooks->start_end_main_source_file)
     debug_hooks->end_source_file (0);
@@ -1347,8 +1439,29 @@ d_parse_file (void)
   errorcount += (global.errors + global.warnings);
 
   /* Write out globals.  */
+  timeTraceBeginPhase (TIMETRACEcodegen, NULL);
   d_finish_compilation (vec_safe_address (global_declarations),
 			vec_safe_length (global_declarations));
+  timeTraceEndPhase ();
+
+  /* Handle -ftime-report-d.  */
+  if (d_option.time_report)
+    {
+      OutBuffer buf;
+      timeTraceReport (&buf);
+
+      const char *name = d_option.time_report_filename;
+
+      if (name && (name[0] != '-' || name[1] != '\0'))
+	{
+	  File *freport = File::create (name);
+	  freport->setbuffer ((void *) buf.data, buf.offset);
+	  freport->ref = 1;
+	  writeFile (Loc (), freport);
+	}
+      else
+	message ("%.*s", (int) buf.offset, (char *) buf.data);
+    }
 }
 
 /* Implements the lang_hooks.types.type_for_mode routine for language D.  */
@@ -33,6 +33,7 @@ class UserAttributeDeclaration;
 class Expression;
 class ClassReferenceExp;
 class Module;
+class TemplateInstance;
 class Statement;
 class Type;
 class TypeFunction;
@@ -43,6 +44,7 @@ struct Loc;
 
 template <typename TYPE> struct Array;
 typedef Array<Expression *> Expressions;
+typedef Array<Module *> Modules;
 
 /* Usage of TREE_LANG_FLAG_?:
    0: METHOD_CALL_EXPR
@@ -598,7 +600,11 @@ extern void d_keep (tree);
 
 /* In decl.cc.  */
 const char *mangle_decl (Dsymbol *);
+extern void mangle_decl_statistics (void);
 extern tree mangle_internal_decl (Dsymbol *, const char *, const char *);
+extern void set_instance_owners (Modules *);
+extern bool instance_codegen_p (TemplateInstance *);
+extern void build_owned_instances (void);
 extern void build_decl_tree (Dsymbol *);
 extern tree get_symbol_decl (Declaration *);
 extern tree declare_extern_var (tree, tree);
@@ -643,6 +649,8 @@ extern void d_finish_compilation (tree *, int);
 
 /* In runtime.cc.  */
 extern tree build_libcall (libcall_fn, Type *, int ...);
+extern tree get_arrayappend_cache (void);
+extern tree get_gc_releases (void);
 
 /* In typeinfo.cc.  */
 extern bool have_typeinfo_p (ClassDeclaration *);
@@ -652,6 +660,7 @@ extern tree get_typeinfo_decl (TypeInfoDeclaration *);
 extern tree get_classinfo_decl (ClassDeclaration *);
 extern tree build_typeinfo (const Loc &, Type *);
 extern void create_typeinfo (Type *, Module *);
+extern void finish_typeinfo_decls (void);
 extern void create_tinfo_types (Module *);
 extern void layout_cpp_typeinfo (ClassDeclaration *);
 extern tree get_cpp_typeinfo_decl (ClassDeclaration *);
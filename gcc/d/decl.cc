@@ -33,6 +33,7 @@ along with GCC; see the file COPYING3.  If not see
 #include "dmd/mangle.h"
 #include "dmd/module.h"
 #include "dmd/nspace.h"
+#include "dmd/stacknew.h"
 #include "dmd/target.h"
 #include "dmd/template.h"
 
@@ -56,18 +57,144 @@ along with GCC; see the file COPYING3.  If not see
 #include "d-tree.h"
 
 
+/* Mangled names already returned by mangle_decl, and the statistics about
+   them reported by mangle_decl_statistics.  */
+
+static hash_map<Dsymbol *, const char *> *mangle_cache;
+static unsigned mangle_hits;
+static unsigned mangle_misses;
+static long mangle_time;
+
 /* Return identifier for the external mangled name of DECL.  */
 
 const char *
 mangle_decl (Dsymbol *decl)
 {
+  if (!mangle_cache)
+    mangle_cache = new hash_map<Dsymbol *, const char *>;
+
+  if (const char **cached = mangle_cache->get (decl))
+    {
+      mangle_hits++;
+      return *cached;
+    }
+
+  long start = get_run_time ();
+  const char *mangled;
+
   if (decl->isFuncDeclaration ())
-    return mangleExact ((FuncDeclaration *)decl);
+    mangled = mangleExact ((FuncDeclaration *)decl);
   else
     {
       OutBuffer buf;
       mangleToBuffer (decl, &buf);
-      return buf.extractString ();
+      mangled = buf.extractString ();
+    }
+
+  mangle_time += get_run_time () - start;
+  mangle_misses++;
+  mangle_cache->put (decl, mangled);
+  return mangled;
+}
+
+/* Print the statistics of mangle_decl for -v.  */
+
+void
+mangle_decl_statistics (void)
+{
+  unsigned total = mangle_hits + mangle_misses;
+  message ("mangle    %u names, %u cache hits (%u%%), %.3f seconds",
+	   mangle_misses, mangle_hits, total ? mangle_hits * 100 / total : 0,
+	   mangle_time / 1000000.0);
+}
+
+/* With -fonly-emit-owned, the modules given on the command line, sorted by
+   name, among which the template instances to generate are shared out.  */
+
+static vec<Module *> instance_owners;
+
+/* Comparison function for sorting instance_owners by name.  */
+
+static int
+instance_owner_cmp (const void *a, const void *b)
+{
+  Module *ma = *(Module * const *) a;
+  Module *mb = *(Module * const *) b;
+  return strcmp (ma->toPrettyChars (), mb->toPrettyChars ());
+}
+
+/* Record MODULES as the owners of the template instances to generate.  */
+
+void
+set_instance_owners (Modules *modules)
+{
+  instance_owners.truncate (0);
+  for (size_t i = 0; i < modules->dim; i++)
+    instance_owners.safe_push ((*modules)[i]);
+  instance_owners.qsort (instance_owner_cmp);
+}
+
+/* Returns the module on the command line that owns template instance TI.
+   An instance that refers to local symbols, such as a nested function passed
+   as an alias parameter, can only be emitted next to them, in the module of
+   its context when that module is on the command line.  Any other instance
+   is attributed to a module chosen by the hash of its mangled name.  As all
+   compilations are given the same modules, they agree on the owner.  */
+
+static Module *
+instance_owner (TemplateInstance *ti)
+{
+  for (TemplateInstance *t = ti; t != NULL; t = t->tempdecl->isInstantiated ())
+    {
+      if (t->enclosing)
+	{
+	  Module *m = t->enclosing->getModule ();
+	  if (m != NULL && m->isRoot ())
+	    return m;
+	  break;
+	}
+    }
+
+  hashval_t hash = htab_hash_string (mangle_decl (ti));
+  return instance_owners[hash % instance_owners.length ()];
+}
+
+/* Returns true if the code for template instance TI is generated in this
+   compilation.  With -fonly-emit-owned, only the compilation of the module
+   that owns the instance emits it, see build_owned_instances.  The other
+   compilations reference its weak definitions.  */
+
+bool
+instance_codegen_p (TemplateInstance *ti)
+{
+  if (!ti->needsCodegen ())
+    return false;
+
+  if (!flag_only_emit_owned || instance_owners.is_empty ())
+    return true;
+
+  return instance_owner (ti) == Module::rootModule;
+}
+
+/* With -fonly-emit-owned, generate the template instances owned by the module
+   being compiled that are held by the members of the other modules on the
+   command line, which are not walked otherwise.  */
+
+void
+build_owned_instances (void)
+{
+  for (unsigned i = 0; i < instance_owners.length (); i++)
+    {
+      Module *m = instance_owners[i];
+      if (m == Module::rootModule || !m->members)
+	continue;
+
+      for (size_t j = 0; j < m->members->dim; j++)
+	{
+	  TemplateInstance *ti = (*m->members)[j]->isTemplateInstance ();
+	  if (ti != NULL)
+	    build_decl_tree (ti);
+	}
     }
 }
 
@@ -328,7 +455,7 @@ public:
     if (isError (d)|| !d->members)
       return;
 
-    if (!d->needsCodegen ())
+    if (!instance_codegen_p (d))
       return;
 
     for (size_t i = 0; i < d->members->dim; i++)
@@ -771,16 +898,22 @@ public:
   }
 
   /* Generate and compile a static TypeInfo declaration, but only if it is
-     needed in the current compilation.  */
+     needed in the current compilation.  This is called once the TypeInfo
+     is referenced, see finish_typeinfo_decls.  */
 
   void visit (TypeInfoDeclaration *d)
   {
+    if (d->semanticRun >= PASSobj)
+      return;
+
     if (speculative_type_p (d->tinfo))
       return;
 
     tree t = get_typeinfo_decl (d);
     DECL_INITIAL (t) = layout_typeinfo (d);
     d_finish_decl (t);
+
+    d->semanticRun = PASSobj;
   }
 
   /* Finish up a function declaration and compile it all the way
@@ -857,6 +990,10 @@ public:
     gcc_assert (d->semanticRun == PASSsemantic3done);
     d->semanticRun = PASSobj;
 
+    /* Find the allocations that can't outlive the function.  */
+    if (flag_stack_new)
+      findStackNewExps (d, d_stack_new_limit);
+
     tree old_context = start_function (d);
 
     tree parm_decl = NULL_TREE;
@@ -1838,7 +1975,7 @@ start_function (FuncDeclaration *fd)
      object file, or it really is extern.  Such as inlinable functions from
      modules not in this compilation, or thunk aliases.  */
   TemplateInstance *ti = fd->isInstantiated ();
-  if (ti && ti->needsCodegen ())
+  if (ti && instance_codegen_p (ti))
     {
       /* Warn about templates instantiated in this compilation.  */
       if (ti == fd->parent)
@@ -534,6 +534,9 @@ public:
     // Sibling nested functions which called this one
     FuncDeclarations siblingCallers;
 
+    // Calls this function was passed to as a delegate argument
+    void *delegateArguments;
+
     FuncDeclarations *inlinedNestedCallees;
 
     unsigned flags;                     // FUNCFLAGxxxxx
@@ -594,6 +597,7 @@ public:
     const char *kind() const;
     FuncDeclaration *isUnique();
     bool needsClosure();
+    FuncDeclaration *escapingNestedFunc();
     bool hasNestedFrameRefs();
     void buildResultVar(Scope *sc, Type *tret);
     Statement *mergeFrequire(Statement *);
@@ -77,9 +77,7 @@ public:
     bool rootImports();         // returns true if module imports root module
 
     int insearch;
-    Identifier *searchCacheIdent;
-    Dsymbol *searchCacheSymbol; // cached value of search
-    int searchCacheFlags;       // cached flags
+    AA *searchCache;            // cached results of search
 
     // module from command line we're imported from,
     // i.e. a module that will be taken all the
@@ -105,6 +103,7 @@ public:
     size_t namelen;             // length of module name in characters
 
     static Module* create(const char *arg, Identifier *ident, int doDocComment, int doHdrGen);
+    static void preparse(Modules *modules, unsigned threads);
 
     static Module *load(Loc loc, Identifiers *packages, Identifier *ident);
 
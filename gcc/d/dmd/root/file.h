@@ -18,7 +18,7 @@ typedef Array<struct File *> Files;
 
 struct File
 {
-    int ref;                    // != 0 if this is a reference to someone else's buffer
+    int ref;                    // != 0 if this is a reference to someone else's buffer, 2 if the file is mapped
     unsigned char *buffer;      // data for our file
     size_t len;                 // amount of data in buffer[]
 
@@ -29,6 +29,10 @@ struct File
 
     const char *toChars() const;
 
+    /* Release the buffer if it is owned, and reset it to empty
+     */
+    void freeBuffer();
+
     /* Read file, return true if error
      */
 
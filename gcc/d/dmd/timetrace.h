@@ -0,0 +1,39 @@
+/* timetrace.h -- Front-end time and memory report for the D front end.
+   Copyright (C) 2018 Free Software Foundation, Inc.
+
+GCC is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 3, or (at your option)
+any later version.
+
+GCC is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with GCC; see the file COPYING3.  If not see
+<http://www.gnu.org/licenses/>.  */
+
+#pragma once
+
+class Module;
+struct OutBuffer;
+
+// Front-end passes recorded by the time report.
+enum TimeTracePhase
+{
+    TIMETRACEread,
+    TIMETRACEparse,
+    TIMETRACEimportAll,
+    TIMETRACEsemantic,
+    TIMETRACEsemantic2,
+    TIMETRACEsemantic3,
+    TIMETRACEdeferred,
+    TIMETRACEcodegen
+};
+
+void timeTraceInit(unsigned topN);
+void timeTraceBeginPhase(int phase, Module *m);
+void timeTraceEndPhase();
+void timeTraceReport(OutBuffer *buf);
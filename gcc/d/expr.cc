@@ -88,6 +88,61 @@ class ExprVisitor : public Visitor
     return false;
   }
 
+  /* Build an inline fast path for appending one element of type ETYPE to the
+     array pointed to by PTR.  If the array ends at the used end of the large
+     block recorded by the runtime in `__d_arrayappend_cache', there is room
+     for another element, and the garbage collector released no memory since
+     the block was recorded, extend it in place.  Otherwise evaluate CALL,
+     the library call that extends the array.  */
+
+  tree append_fast_path (tree ptr, Type *etype, tree call)
+  {
+    tree cache = get_arrayappend_cache ();
+    tree base_field = TYPE_FIELDS (TREE_TYPE (cache));
+    tree limit_field = DECL_CHAIN (base_field);
+    tree releases_field = DECL_CHAIN (limit_field);
+    tree base = d_save_expr (component_ref (cache, base_field));
+    tree limit = component_ref (cache, limit_field);
+    tree releases = component_ref (cache, releases_field);
+
+    tree array = build_deref (ptr);
+    tree length = d_save_expr (d_array_length (array));
+    tree data = d_save_expr (build_nop (ptr_type_node, d_array_ptr (array)));
+    tree size = size_int (etype->size ());
+    tree end = build_offset (data, size_mult_expr (length, size));
+    end = d_save_expr (end);
+
+    /* The used length of a large block is stored at its start, and the
+       array data follows at offset 16, see LARGEPREFIX in rt/lifetime.d.  */
+    tree sizet = build_ctype (Type::tsize_t);
+    tree used = indirect_ref (sizet, base);
+    tree used_end = build_offset (base, build2 (PLUS_EXPR, sizet, used,
+						size_int (16)));
+
+    /* Check the cached block bounds before reading the used length, the
+       block may be unrelated to the array.  If memory was released since
+       the block was recorded, it may have been freed, shrunk, or reused.  */
+    tree cond = build_boolop (NE_EXPR, base, null_pointer_node);
+    cond = build_boolop (TRUTH_ANDIF_EXPR, cond,
+			 build_boolop (EQ_EXPR, releases, get_gc_releases ()));
+    cond = build_boolop (TRUTH_ANDIF_EXPR, cond,
+			 build_boolop (GE_EXPR, data, base));
+    cond = build_boolop (TRUTH_ANDIF_EXPR, cond,
+			 build_boolop (LE_EXPR, build_offset (end, size), limit));
+    cond = build_boolop (TRUTH_ANDIF_EXPR, cond,
+			 build_boolop (EQ_EXPR, end, used_end));
+
+    tree fast = modify_expr (used, build2 (PLUS_EXPR, sizet, used, size));
+    fast = compound_expr (fast, modify_expr (d_array_length (array),
+					     size_binop (PLUS_EXPR, length,
+							 size_one_node)));
+    fast = compound_expr (fast, array);
+
+    tree result = build_condition (TREE_TYPE (call), cond, fast, call);
+    /* Evaluate the array first, it could append to another array.  */
+    return compound_expr (compound_expr (end, base), result);
+  }
+
   /* Determine if expression is suitable lvalue.  */
 
   bool lvalue_p (Expression *e)
@@ -837,9 +892,19 @@ public:
 	  }
 	else if (same_type_p (etype, tb2))
 	  {
-	    /* Append an element.  */
+	    /* Append an element.  Plain data can be appended without calling
+	       the runtime if there's room in the array's block.  */
+	    bool inline_p = (flag_inline_append && optimize
+			     && tb1->ty == Tarray && !e->type->isShared ()
+			     && etype->size () != 0
+			     && !needs_postblit (etype) && !needs_dtor (etype));
+	    if (inline_p)
+	      ptr = d_save_expr (ptr);
+
 	    tree result = build_libcall (LIBCALL_ARRAYAPPENDCTX, e->type, 3,
 					 tinfo, ptr, size_one_node);
+	    if (inline_p)
+	      result = append_fast_path (ptr, etype, result);
 	    result = d_save_expr (result);
 
 	    /* Assign e2 to last element.  */
@@ -2258,6 +2323,18 @@ public:
     if (e->allocator)
       gcc_assert (e->newargs);
 
+    if (warn_gc_alloc && !e->onstack && !e->allocator
+	&& !(global.params.ehnogc && e->thrownew))
+      {
+	if (e->heapReason)
+	  warning_at (make_location_t (e->loc), OPT_Wgc_alloc,
+		      "%qs is allocated on the GC heap because %s",
+		      e->toChars (), e->heapReason);
+	else
+	  warning_at (make_location_t (e->loc), OPT_Wgc_alloc,
+		      "%qs is allocated on the GC heap", e->toChars ());
+      }
+
     if (tb->ty == Tclass)
       {
 	/* Allocating a new class.  */
@@ -2272,8 +2349,9 @@ public:
 	if (e->onstack)
 	  {
 	    /* If being used as an initializer for a local variable with scope
-	       storage class, then the instance is allocated on the stack
-	       rather than the heap or using the class specific allocator.  */
+	       storage class, or if the instance can't outlive the function,
+	       then the instance is allocated on the stack rather than the heap
+	       or using the class specific allocator.  */
 	    tree var = build_local_temp (TREE_TYPE (type));
 	    new_call = build_nop (type, build_address (var));
 	    setup_exp = modify_expr (var, aggregate_initializer_decl (cd));
@@ -2436,11 +2514,35 @@ public:
 		return;
 	      }
 
-	    libcall_fn libcall = tarray->next->isZeroInit ()
-	      ? LIBCALL_NEWARRAYT : LIBCALL_NEWARRAYIT;
-	    result = build_libcall (libcall, tb, 2,
-				    build_typeinfo (e->loc, e->type),
-				    build_expr (arg));
+	    if (e->onstack)
+	      {
+		/* The array can't outlive the function, so allocate it on the
+		   stack as a static array of the constant length.  */
+		dinteger_t dim = arg->toInteger ();
+		Type *tsa = tarray->next->sarrayOf (dim);
+		tree var = build_local_temp (build_ctype (tsa));
+		tree init;
+
+		if (tarray->next->isZeroInit ())
+		  init = build_constructor (TREE_TYPE (var), NULL);
+		else
+		  {
+		    Expression *einit = tarray->next->defaultInitLiteral (e->loc);
+		    init = build_array_from_val (tsa, build_expr (einit));
+		  }
+
+		result = d_array_value (build_ctype (e->type), size_int (dim),
+					build_address (var));
+		result = compound_expr (modify_expr (var, init), result);
+	      }
+	    else
+	      {
+		libcall_fn libcall = tarray->next->isZeroInit ()
+		  ? LIBCALL_NEWARRAYT : LIBCALL_NEWARRAYIT;
+		result = build_libcall (libcall, tb, 2,
+					build_typeinfo (e->loc, e->type),
+					build_expr (arg));
+	      }
 	  }
 	else
 	  {
@@ -718,6 +718,11 @@ build_module_tree (Module *decl)
 	}
     }
 
+  /* Generate the template instances this module owns that were attributed to
+     the other modules on the command line.  */
+  if (flag_only_emit_owned && decl == Module::rootModule)
+    build_owned_instances ();
+
   /* Default behavior is to always generate module info because of templates.
      Can be switched off for not compiling against runtime library.  */
   if (global.params.useModuleInfo
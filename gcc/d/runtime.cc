@@ -25,6 +25,7 @@ along with GCC; see the file COPYING3.  If not see
 #include "tree.h"
 #include "fold-const.h"
 #include "stringpool.h"
+#include "varasm.h"
 
 #include "d-tree.h"
 
@@ -313,3 +314,61 @@ build_libcall (libcall_fn libcall, Type *type, int nargs, ...)
   /* Assumes caller knows what it is doing.  */
   return convert (build_ctype (type), result);
 }
+
+/* The declarations of `__d_arrayappend_cache' and `__d_gc_releases', built
+   on first use.  */
+
+static tree arrayappend_cache_decl;
+static tree gc_releases_decl;
+
+/* Return the thread-local record of the last large array block extended in
+   place by `_d_arrayappendcTX'.  It has three fields, the base of the block,
+   the end of the space that the array in the block can grow into, and the
+   value of `__d_gc_releases' when the block was recorded.  */
+
+tree
+get_arrayappend_cache (void)
+{
+  if (arrayappend_cache_decl)
+    return arrayappend_cache_decl;
+
+  tree type = make_struct_type ("AppendCache", 3,
+				get_identifier ("base"), ptr_type_node,
+				get_identifier ("limit"), ptr_type_node,
+				get_identifier ("releases"), size_type_node);
+  tree decl = build_decl (UNKNOWN_LOCATION, VAR_DECL,
+			  get_identifier ("__d_arrayappend_cache"), type);
+  DECL_EXTERNAL (decl) = 1;
+  TREE_PUBLIC (decl) = 1;
+  DECL_ARTIFICIAL (decl) = 1;
+  DECL_VISIBILITY (decl) = VISIBILITY_DEFAULT;
+  DECL_VISIBILITY_SPECIFIED (decl) = 1;
+  set_decl_tls_model (decl, decl_default_tls_model (decl));
+  d_keep (decl);
+
+  arrayappend_cache_decl = decl;
+  return decl;
+}
+
+/* Return the counter of the times the garbage collector released memory
+   other than by a collection, after which the block recorded in
+   `__d_arrayappend_cache' may have been reused.  */
+
+tree
+get_gc_releases (void)
+{
+  if (gc_releases_decl)
+    return gc_releases_decl;
+
+  tree decl = build_decl (UNKNOWN_LOCATION, VAR_DECL,
+			  get_identifier ("__d_gc_releases"), size_type_node);
+  DECL_EXTERNAL (decl) = 1;
+  TREE_PUBLIC (decl) = 1;
+  DECL_ARTIFICIAL (decl) = 1;
+  DECL_VISIBILITY (decl) = VISIBILITY_DEFAULT;
+  DECL_VISIBILITY_SPECIFIED (decl) = 1;
+  d_keep (decl);
+
+  gc_releases_decl = decl;
+  return decl;
+}
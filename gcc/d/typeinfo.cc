@@ -37,6 +37,7 @@ along with GCC; see the file COPYING3.  If not see
 #include "stringpool.h"
 #include "toplev.h"
 #include "stor-layout.h"
+#include "langhooks.h"
 
 #include "d-tree.h"
 #include "d-target.h"
@@ -335,26 +336,22 @@ class TypeInfoVisitor : public Visitor
     CONSTRUCTOR_APPEND_ELT (this->init_, NULL_TREE, value);
   }
 
-  /* Write out STR as a static D string literal.  */
+  /* Write out STR as a static D string literal.  The literal includes the
+     terminating null, so that it is emitted as a constant in a mergeable
+     string section, shared with every other use of the same name.  */
 
   void layout_string (const char *str)
   {
     unsigned len = strlen (str);
-    tree value = build_string (len, str);
+    tree value = build_string (len + 1, str);
 
-    TREE_TYPE (value) = make_array_type (Type::tchar, len);
+    TREE_TYPE (value) = make_array_type (Type::tchar, len + 1);
     TREE_CONSTANT (value) = 1;
     TREE_READONLY (value) = 1;
     TREE_STATIC (value) = 1;
 
-    /* Taking the address, so assign the literal to a static var.  */
-    tree decl = build_artificial_decl (TREE_TYPE (value), value);
-    TREE_READONLY (decl) = 1;
-    DECL_EXTERNAL (decl) = 0;
-    d_pushdecl (decl);
-
     value = d_array_value (build_ctype (Type::tchar->arrayOf ()),
-			   size_int (len), build_address (decl));
+			   size_int (len), build_address (value));
     this->layout_field (value);
   }
 
@@ -1296,6 +1293,29 @@ public:
   }
 };
 
+/* TypeInfo is only generated in a compilation if something references it.
+   Each TypeInfo declaration referenced for the first time is recorded here
+   together with what referenced it, and generated by finish_typeinfo_decls
+   once all code has been generated.  */
+
+struct typeinfo_request
+{
+  TypeInfoDeclaration *decl;
+  /* The name of the function whose body referenced DECL, if any.  */
+  const char *function;
+  /* The TypeInfo whose contents referenced DECL, if any.  */
+  TypeInfoDeclaration *typeinfo;
+};
+
+static vec<typeinfo_request> typeinfo_requests;
+
+/* The TypeInfo being generated by finish_typeinfo_decls.  */
+static TypeInfoDeclaration *typeinfo_referrer;
+
+/* Number of TypeInfo declarations created that would be generated in this
+   compilation if they were referenced.  */
+static unsigned typeinfo_created;
+
 /* Get the VAR_DECL of the TypeInfo for DECL.  If this does not yet exist,
    create it.  The TypeInfo decl provides information about the type of a given
    expression or object.  */
@@ -1312,9 +1332,59 @@ get_typeinfo_decl (TypeInfoDeclaration *decl)
   decl->accept (&v);
   gcc_assert (decl->csym != NULL_TREE);
 
+  /* This is the first reference to DECL, so its contents are needed.  */
+  if (!builtin_typeinfo_p (decl->tinfo))
+    {
+      const char *function = NULL;
+      if (global.params.verbose && current_function_decl)
+	function = lang_hooks.decl_printable_name (current_function_decl, 2);
+
+      typeinfo_request req = { decl, function, typeinfo_referrer };
+      typeinfo_requests.safe_push (req);
+    }
+
   return decl->csym;
 }
 
+/* Generate the contents of all TypeInfo referenced in this compilation.
+   Generating one TypeInfo can reference others, which are then generated
+   in turn.  With -v, report each TypeInfo and what first referenced it.  */
+
+void
+finish_typeinfo_decls (void)
+{
+  for (unsigned i = 0; i < typeinfo_requests.length (); i++)
+    {
+      typeinfo_request req = typeinfo_requests[i];
+
+      if (global.params.verbose)
+	{
+	  const char *type = req.decl->tinfo->toChars ();
+	  if (req.typeinfo)
+	    message ("typeinfo  %s, referenced by TypeInfo of %s", type,
+		     req.typeinfo->tinfo->toChars ());
+	  else if (req.function)
+	    message ("typeinfo  %s, referenced by function %s", type,
+		     req.function);
+	  else
+	    message ("typeinfo  %s, referenced by static data", type);
+	}
+
+      typeinfo_referrer = req.decl;
+      build_decl_tree (req.decl);
+      typeinfo_referrer = NULL;
+    }
+
+  if (global.params.verbose)
+    {
+      unsigned generated = typeinfo_requests.length ();
+      message ("typeinfo  %u generated, %u not referenced", generated,
+	       typeinfo_created > generated ? typeinfo_created - generated : 0);
+    }
+
+  typeinfo_requests.truncate (0);
+}
+
 /* Get the VAR_DECL of the ClassInfo for DECL.  If this does not yet exist,
    create it.  The ClassInfo decl provides information about the dynamic type
    of a given class type or object.  */
@@ -1431,10 +1501,12 @@ get_cpp_typeinfo_decl (ClassDeclaration *decl)
   return decl->cpp_type_info_ptr_sym;
 }
 
-/* Get the exact TypeInfo for TYPE, if it doesn't exist, create it.  */
+/* Get the exact TypeInfo for TYPE, if it doesn't exist, create it.
+   The contents of the TypeInfo are only generated if it is referenced,
+   so the module that requested it does not matter.  */
 
 void
-create_typeinfo (Type *type, Module *mod)
+create_typeinfo (Type *type, Module *)
 {
   /* Do this since not all Type's are merged.  */
   Type *t = type->merge2 ();
@@ -1591,15 +1663,10 @@ create_typeinfo (Type *type, Module *mod)
       gcc_assert (t->vtinfo);
 
       /* If this has a custom implementation in rt/typeinfo, then
-	 do not generate a COMDAT for it.  */
+	 do not generate a COMDAT for it.  Otherwise it is only generated
+	 once it is referenced, see get_typeinfo_decl.  */
       if (!builtin_typeinfo_p (t))
-	{
-	  /* Find module that will go all the way to an object file.  */
-	  if (mod)
-	    mod->members->push (t->vtinfo);
-	  else
-	    build_decl_tree (t->vtinfo);
-	}
+	typeinfo_created++;
     }
   /* Types aren't merged, but we can share the vtinfo's.  */
   if (!type->vtinfo)